@@ -0,0 +1,426 @@
+// Checks and benchmarks for RodeysTweaksGamingOptimizer.cpp, built as their own program:
+//
+//     g++ -std=c++20 -O2 -pthread RodeysTweaksChecks.cpp -o RodeysTweaksChecks
+//
+// Exits with a non-zero status if any check fails.
+#define RODEYS_TWEAKS_NO_MAIN
+#include "RodeysTweaksGamingOptimizer.cpp"
+
+// ===============================
+// Setting Lookup Benchmark
+// ===============================
+namespace SettingBenchmarks {
+    // Times name lookups and a full settings-file load for a generated setting space.
+    void runLookupBenchmark(std::size_t settingCount) {
+        GameOptimizer optimizer;
+        for (std::size_t i = 0; i < settingCount; ++i) {
+            optimizer.addSetting("Setting " + std::to_string(i), 1, 0, 10);
+        }
+
+        const std::string filePath = "bench_settings.txt";
+        {
+            std::ofstream file(filePath);
+            for (std::size_t i = 0; i < settingCount; ++i) {
+                file << "Setting " << i << "=" << (i % 11) << "\n";
+            }
+        }
+
+        Benchmark benchmark;
+        std::size_t found = 0;
+        benchmark.start();
+        for (std::size_t i = 0; i < settingCount; ++i) {
+            if (optimizer.findSetting("Setting " + std::to_string(i)) != GameOptimizer::InvalidSettingId) {
+                ++found;
+            }
+        }
+        benchmark.stop();
+        benchmark.printResults("Lookup of " + std::to_string(found) + " settings");
+
+        SettingsManager settingsManager(filePath);
+        benchmark.start();
+        settingsManager.loadSettings(optimizer);
+        benchmark.stop();
+        benchmark.printResults("Loading " + std::to_string(settingCount) + " settings");
+
+        std::remove(filePath.c_str());
+    }
+
+    void runLookupBenchmarks() {
+        runLookupBenchmark(10000);
+        runLookupBenchmark(100000);
+    }
+}
+
+// ===============================
+// Name Table Checks
+// ===============================
+namespace NameTableChecks {
+    // Interns names around the dedicated-block threshold, long first, and checks every
+    // one still reads back intact once the rest are stored.
+    bool runArenaCheck() {
+        NameTable table;
+        std::vector<std::string> names = { std::string(5000, 'L') };
+        for (int i = 0; i < 200; ++i) {
+            names.push_back(std::string(200, static_cast<char>('a' + i % 26)) + std::to_string(i));
+            if (i % 50 == 0) names.push_back(std::string(4097 + i, static_cast<char>('A' + i % 26)));
+        }
+
+        std::vector<NameId> ids;
+        for (const std::string& name : names) ids.push_back(table.intern(name));
+
+        bool passed = true;
+        for (std::size_t i = 0; i < names.size(); ++i) {
+            passed = passed && table.text(ids[i]) == names[i] && table.find(names[i]) == ids[i];
+        }
+        std::cout << (passed ? "PASS" : "FAIL") << " name table: long names interned between short ones\n";
+        return passed;
+    }
+}
+
+// ===============================
+// Planning Checks
+// ===============================
+namespace PlanningChecks {
+    // Plans the built-in model at several targets from different starting resolutions and
+    // checks the plan does not depend on where it started. At 105 FPS the best plan keeps
+    // resolution at its minimum and spends the budget on textures.
+    bool runStartIndependenceCheck() {
+        bool passed = true;
+        for (int targetFps : { 30, 60, 105, 144, 240 }) {
+            std::vector<int> first;
+            for (int resolution : { 720, 1080, 2160 }) {
+                GameOptimizer optimizer;
+                optimizer.updateSetting(static_cast<GameOptimizer::SettingId>(BuiltinSetting::Resolution), resolution);
+                std::span<const int> plan = optimizer.planSettings(targetFps);
+                if (first.empty()) first.assign(plan.begin(), plan.end());
+                passed = passed && std::equal(plan.begin(), plan.end(), first.begin(), first.end());
+            }
+            if (targetFps == 105) passed = passed && first == std::vector<int>{ 720, 5, 1 };
+        }
+        std::cout << (passed ? "PASS" : "FAIL") << " planning: plans independent of starting values\n";
+        return passed;
+    }
+
+    // Installs a decision table for 30-120 FPS on a model with an unmodeled parent, then
+    // checks optimizeSettings matches the solver for a target past the table and after
+    // the parent changes, where the table's rows no longer apply.
+    bool runDecisionTableFallbackCheck() {
+        GameOptimizer optimizer;
+        GameOptimizer::SettingId upscaler = optimizer.addSetting("Upscaler Mode", 1, 1, 3);
+        optimizer.addDependency(upscaler, static_cast<GameOptimizer::SettingId>(BuiltinSetting::ShadowQuality));
+        bool passed = optimizer.useDecisionTable(std::make_shared<DecisionTable>(optimizer.buildDecisionTable(30, 120, 10, {})));
+
+        auto appliesPlan = [&optimizer](int targetFps) {
+            std::vector<int> plan;
+            std::span<const int> planned = optimizer.planSettings(targetFps);
+            plan.assign(planned.begin(), planned.end());
+            optimizer.optimizeSettings(targetFps);
+            std::span<const int> current = optimizer.settingValues();
+            return std::equal(current.begin(), current.end(), plan.begin(), plan.end());
+        };
+        passed = passed && appliesPlan(60) && appliesPlan(240);
+        optimizer.updateSetting(upscaler, 3);
+        passed = passed && appliesPlan(60) && appliesPlan(90);
+
+        std::cout << (passed ? "PASS" : "FAIL") << " planning: decision table falls back past its targets and inputs\n";
+        return passed;
+    }
+}
+
+// ===============================
+// Allocation Checks
+// ===============================
+// Global operator new is replaced, in this program only, with a counting version so the
+// checks below can show which paths allocate.
+namespace AllocationChecks {
+    std::atomic<std::size_t> allocationCount{0};
+
+    // Heap allocations made while `work` runs, on any thread.
+    template <typename Work>
+    std::size_t countAllocations(Work&& work) {
+        const std::size_t before = allocationCount.load();
+        work();
+        return allocationCount.load() - before;
+    }
+}
+
+void* operator new(std::size_t size) {
+    AllocationChecks::allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(size ? size : 1)) return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    AllocationChecks::allocationCount.fetch_add(1, std::memory_order_relaxed);
+    const std::size_t align = static_cast<std::size_t>(alignment);
+    if (void* pointer = std::aligned_alloc(align, (std::max<std::size_t>(size, 1) + align - 1) / align * align)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+// Out of line: inlined into callers, GCC flags the free() as mismatched with operator new.
+__attribute__((noinline)) void operator delete(void* pointer) noexcept { std::free(pointer); }
+__attribute__((noinline)) void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+__attribute__((noinline)) void operator delete(void* pointer, std::align_val_t) noexcept { std::free(pointer); }
+__attribute__((noinline)) void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+
+namespace AllocationChecks {
+    struct ReadPathCounts {
+        std::size_t iterate;
+        std::size_t snapshotRead;
+        std::size_t save;
+        std::size_t optimize;
+        std::size_t parallelOptimize;
+    };
+
+    ReadPathCounts measureReadPaths(std::size_t settingCount) {
+        GameOptimizer optimizer;
+        for (std::size_t i = 0; i < settingCount; ++i) {
+            GameOptimizer::SettingId id = optimizer.addSetting("Setting " + std::to_string(i), 1, 0, 10);
+            if (i % 2 == 0) optimizer.setFrameCost(id, 0.01, 1.0);
+        }
+        optimizer.optimizeSettings(60);
+
+        const std::string filePath = "alloc_check_settings.txt";
+        SettingsManager settingsManager(filePath);
+        ParallelOptimizer parallelOptimizer(optimizer, 4);
+        parallelOptimizer.parallelOptimize(60); // warms the pool's task queue
+
+        ReadPathCounts counts{};
+        long long sum = 0;
+        counts.iterate = countAllocations([&]() {
+            for (GameOptimizer::SettingRef setting : optimizer.settingsView()) sum += setting.value;
+            optimizer.forEachSetting([&sum](const GameOptimizer::SettingRef& setting) { sum += setting.name.size(); });
+            for (int value : optimizer.settingValues()) sum += value;
+        });
+        counts.snapshotRead = countAllocations([&]() {
+            GameOptimizer::SnapshotHandle snapshot = optimizer.snapshot();
+            for (std::size_t id = 0; id < snapshot->size(); ++id) sum += snapshot->value(id) + snapshot->name(id).size();
+        });
+        counts.save = countAllocations([&]() { settingsManager.saveSettings(optimizer); });
+        counts.optimize = countAllocations([&]() { optimizer.optimizeSettings(60); });
+        counts.parallelOptimize = countAllocations([&]() { parallelOptimizer.parallelOptimize(60); });
+
+        std::remove(filePath.c_str());
+        return counts;
+    }
+
+    // Readers must never allocate per setting: iterating and re-optimizing unchanged
+    // settings allocate nothing, and save and parallel optimize allocate the same fixed
+    // amount (file buffer, pool tasks, console text) at any setting count.
+    bool runReadPathChecks() {
+        const ReadPathCounts small = measureReadPaths(1000);
+        const ReadPathCounts large = measureReadPaths(8000);
+
+        bool passed = true;
+        auto report = [&passed](const char* name, std::size_t smallCount, std::size_t largeCount, bool expectZero) {
+            const bool ok = (smallCount == largeCount) && (!expectZero || largeCount == 0);
+            passed = passed && ok;
+            std::cout << (ok ? "PASS " : "FAIL ") << name << ": " << smallCount << " allocations at 1000 settings, "
+                      << largeCount << " at 8000\n";
+        };
+        report("iterate", small.iterate, large.iterate, true);
+        report("snapshot read", small.snapshotRead, large.snapshotRead, true);
+        report("save", small.save, large.save, false);
+        report("optimize", small.optimize, large.optimize, true);
+        report("parallel optimize", small.parallelOptimize, large.parallelOptimize, false);
+        return passed;
+    }
+}
+
+// ===============================
+// Scheduling Tweak Check
+// ===============================
+#include <csignal>
+#include <sys/wait.h>
+
+// Runs ProcessSchedulingTweak against a forked child standing in for a game: its main
+// thread plus one helper thread named "helper". Needs root, since restoring a lower nice
+// value or leaving SCHED_IDLE is privileged.
+namespace SchedulingChecks {
+    struct ThreadSettings {
+        int nice = 0;
+        int ioprio = 0;
+        int policy = 0;
+        cpu_set_t affinity{};
+    };
+
+    inline bool readThreadSettings(pid_t tid, ThreadSettings& settings) {
+        errno = 0;
+        settings.nice = getpriority(PRIO_PROCESS, static_cast<id_t>(tid));
+        settings.ioprio = static_cast<int>(syscall(SYS_ioprio_get, 1, tid));
+        settings.policy = sched_getscheduler(tid);
+        return errno == 0 && settings.ioprio >= 0 && settings.policy >= 0 &&
+               sched_getaffinity(tid, sizeof(settings.affinity), &settings.affinity) == 0;
+    }
+
+    inline bool sameSettings(const ThreadSettings& a, const ThreadSettings& b) {
+        return a.nice == b.nice && a.ioprio == b.ioprio && a.policy == b.policy && CPU_EQUAL(&a.affinity, &b.affinity);
+    }
+
+    inline void* helperThread(void*) {
+        while (true) pause();
+        return nullptr;
+    }
+
+    // Exits once the parent closes the other end of the pipe.
+    inline void* workerThread(void* releaseFd) {
+        char byte;
+        while (::read(static_cast<int>(reinterpret_cast<std::intptr_t>(releaseFd)), &byte, 1) > 0) {}
+        return nullptr;
+    }
+
+    // Forks a child that starts a "helper" thread and a "worker" thread, reports ready
+    // through a pipe and then sleeps until killed. The worker exits when `release` is
+    // closed. Returns the child's pid, or -1.
+    inline pid_t spawnGame(int& release) {
+        int ready[2];
+        int releasePipe[2];
+        if (pipe(ready) != 0) return -1;
+        if (pipe(releasePipe) != 0) {
+            close(ready[0]);
+            close(ready[1]);
+            return -1;
+        }
+
+        pid_t child = fork();
+        if (child == 0) {
+            close(ready[0]);
+            close(releasePipe[1]);
+            pthread_t helper, worker;
+            void* releaseFd = reinterpret_cast<void*>(static_cast<std::intptr_t>(releasePipe[0]));
+            if (pthread_create(&helper, nullptr, helperThread, nullptr) == 0 &&
+                pthread_create(&worker, nullptr, workerThread, releaseFd) == 0) {
+                pthread_setname_np(helper, "helper");
+                pthread_setname_np(worker, "worker");
+                char byte = 1;
+                (void)!::write(ready[1], &byte, 1);
+            }
+            while (true) pause();
+        }
+
+        close(ready[1]);
+        close(releasePipe[0]);
+        release = releasePipe[1];
+        char byte = 0;
+        const bool started = child > 0 && ::read(ready[0], &byte, 1) == 1;
+        close(ready[0]);
+        if (!started) {
+            close(release);
+            if (child > 0) {
+                kill(child, SIGKILL);
+                waitpid(child, nullptr, 0);
+            }
+            return -1;
+        }
+        return child;
+    }
+
+    inline pid_t findThread(pid_t process, const std::string& name) {
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator("/proc/" + std::to_string(process) + "/task", error)) {
+            std::ifstream commFile(entry.path() / "comm");
+            std::string comm;
+            std::getline(commFile, comm);
+            if (comm == name) return static_cast<pid_t>(std::stol(entry.path().filename().string()));
+        }
+        return -1;
+    }
+
+    // Applies nice, affinity, I/O priority and SCHED_IDLE for the helper and checks that
+    // they took effect. Lets the worker exit, restores and checks that the originals are
+    // back on the remaining threads. Then kills the child and checks that the tweak
+    // notices and restores nothing.
+    bool runProcessSchedulingCheck() {
+        if (geteuid() != 0) {
+            std::cout << "SKIP process scheduling: needs root\n";
+            return true;
+        }
+
+        int release = -1;
+        pid_t game = spawnGame(release);
+        if (game < 0) {
+            std::cout << "FAIL process scheduling: could not start the child process\n";
+            return false;
+        }
+        pid_t helper = findThread(game, "helper");
+        pid_t worker = findThread(game, "worker");
+
+        bool passed = helper > 0 && worker > 0;
+        auto expect = [&passed](bool condition, const char* what) {
+            if (!condition) std::cout << "FAIL process scheduling: " << what << "\n";
+            passed = passed && condition;
+        };
+
+        ThreadSettings mainBefore, helperBefore, mainAfter, helperAfter;
+        expect(readThreadSettings(game, mainBefore) && readThreadSettings(helper, helperBefore), "read originals");
+
+        SchedulingPlan plan;
+        plan.cpus = { 0 };
+        plan.setNice = true;
+        plan.nice = mainBefore.nice + 5;
+        plan.ioClass = SchedulingPlan::IoClassIdle;
+        plan.ioLevel = 0;
+        plan.helperPolicy = SCHED_IDLE;
+        plan.helperNames = { "helper" };
+
+        {
+            ProcessSchedulingTweak tweak(game, plan);
+            try {
+                tweak.apply();
+            } catch (const std::exception& ex) {
+                expect(false, ex.what());
+            }
+
+            expect(readThreadSettings(game, mainAfter) && readThreadSettings(helper, helperAfter), "read applied values");
+            expect(mainAfter.nice == plan.nice && helperAfter.nice == plan.nice, "nice applied");
+            expect(CPU_COUNT(&mainAfter.affinity) == 1 && CPU_ISSET(0, &mainAfter.affinity), "affinity applied");
+            expect(mainAfter.ioprio >> 13 == SchedulingPlan::IoClassIdle, "I/O priority applied");
+            expect(helperAfter.policy == SCHED_IDLE && mainAfter.policy == mainBefore.policy, "helper policy applied");
+            expect(tweak.trackedThreads() == 3, "all threads tracked");
+
+            // The worker exits before the restore and must be skipped, not touched.
+            close(release);
+            const std::string workerPath = "/proc/" + std::to_string(game) + "/task/" + std::to_string(worker);
+            for (int wait = 0; wait < 20 && std::filesystem::exists(workerPath); ++wait) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            }
+            expect(!std::filesystem::exists(workerPath), "worker exited");
+            expect(tweak.restore() == 2, "running threads restored, exited one skipped");
+            expect(readThreadSettings(game, mainAfter) && readThreadSettings(helper, helperAfter), "read restored values");
+            expect(sameSettings(mainAfter, mainBefore) && sameSettings(helperAfter, helperBefore), "originals back");
+
+            try {
+                tweak.apply();
+            } catch (const std::exception& ex) {
+                expect(false, ex.what());
+            }
+            kill(game, SIGKILL);
+            waitpid(game, nullptr, 0);
+            for (int wait = 0; wait < 20 && !tweak.gameExited(); ++wait) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            }
+            expect(tweak.gameExited() && tweak.trackedThreads() == 0, "exit noticed");
+            expect(tweak.restore() == 0, "nothing restored after exit");
+        }
+
+        std::cout << (passed ? "PASS" : "FAIL") << " process scheduling: apply and restore on a forked child\n";
+        return passed;
+    }
+}
+
+// ===============================
+// Entry Point
+// ===============================
+int main() {
+    SettingBenchmarks::runLookupBenchmarks();
+
+    bool passed = true;
+    passed = NameTableChecks::runArenaCheck() && passed;
+    passed = PlanningChecks::runStartIndependenceCheck() && passed;
+    passed = PlanningChecks::runDecisionTableFallbackCheck() && passed;
+    passed = AllocationChecks::runReadPathChecks() && passed;
+    passed = SchedulingChecks::runProcessSchedulingCheck() && passed;
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}